@@ -1,7 +1,5 @@
 #include "chip8.h"
 
-int key_pressed = -1;
-
 uint8_t chip8_fontset[80] = {
   0xF0, 0x90, 0x90, 0x90, 0xF0, // 0
   0x20, 0x60, 0x20, 0x20, 0x70, // 1
@@ -25,6 +23,45 @@ void cleanup(std::ofstream& state_file) {
   if (state_file) state_file.close();
 }
 
+bool loadROM(Chip8& chip8_state, const std::string& rom_path) {
+  //Load in Chip-8 Font Data
+  for (int i = 0; i < 80; i++) {
+    chip8_state.mem[FONT_START + i] = chip8_fontset[i];
+  }
+
+  std::ifstream rom(rom_path, std::ios::binary | std::ios::ate);
+  if (!rom) {
+    std::cerr << "Error: Could not open ROM file: " << rom_path << std::endl;
+    return false;
+  }
+
+  chip8_state.romSize = rom.tellg();
+  rom.seekg(0, std::ios::beg);
+  if (chip8_state.romSize > static_cast<std::streamsize>(MEM_SIZE - loadAddress)) {
+    std::cerr << "Error: ROM file is too large to fit in memory." << std::endl;
+    return false;
+  }
+
+  if (!rom.read(reinterpret_cast<char*>(&chip8_state.mem[loadAddress]), chip8_state.romSize)) {
+    std::cerr << "Error reading ROM file." << std::endl;
+    return false;
+  }
+  return true;
+}
+
+const char* chip8StatusString(Chip8Status status) {
+  switch (status) {
+    case CHIP8_RUNNING: return "Running";
+    case CHIP8_HALTED: return "Halted";
+    case CHIP8_STACK_OVERFLOW: return "Stack overflow";
+    case CHIP8_STACK_UNDERFLOW: return "Stack underflow";
+    case CHIP8_UNKNOWN_INSTRUCTION: return "Instruction not implemented or ROM error";
+    case CHIP8_MEMORY_OUT_OF_BOUNDS: return "Memory access out of bounds";
+    case CHIP8_INVALID_KEY: return "Invalid key index";
+  }
+  return "Unknown status";
+}
+
 void writeStateToFile(const Chip8& chip8_state, uint16_t instruction, std::ofstream& file) {
     file << "PC: " << chip8_state.PC << "\n";
     file << "Instruction: 0x" << std::uppercase << instruction << "\n";
@@ -59,17 +96,18 @@ void writeStateToFile(const Chip8& chip8_state, uint16_t instruction, std::ofstr
 
 }
 
-bool emulateCycle(Chip8& chip8_state, uint16_t& instruction, std::ofstream& state_file) {
-    bool running = true;
-
+Chip8Status emulateCycle(Chip8& chip8_state, uint16_t& instruction, std::ofstream& state_file) {
     if ((chip8_state.PC >= (loadAddress + chip8_state.romSize)))
-        return (running = false);
+        return CHIP8_HALTED;
+    if (static_cast<size_t>(chip8_state.PC) + 1 >= MEM_SIZE)
+        return CHIP8_MEMORY_OUT_OF_BOUNDS;
 
     //Fetch instruction from virtual memory
     instruction = (chip8_state.mem[chip8_state.PC] << 8)  | chip8_state.mem[chip8_state.PC + 1];
 
     //Dump chip8_state contents
-    writeStateToFile(chip8_state, instruction, state_file);
+    if (state_file.is_open())
+      writeStateToFile(chip8_state, instruction, state_file);
 
     //Determine operation from extracted opcode
     switch (NIBBLE3) {
@@ -84,11 +122,9 @@ bool emulateCycle(Chip8& chip8_state, uint16_t& instruction, std::ofstream& stat
           if(chip8_state.SP > 0) {
             chip8_state.PC = chip8_state.stack[--chip8_state.SP];
             chip8_state.stack[chip8_state.SP] = 0; //clear old return value, not technically necessary, just for clarity in statedump file
-            return true;
+            return CHIP8_RUNNING;
           } else {
-            std::cerr << "Stack underflow\n";
-            cleanup(state_file);
-            exit(EXIT_FAILURE );
+            return CHIP8_STACK_UNDERFLOW;
           }
         }
         break;
@@ -96,39 +132,37 @@ bool emulateCycle(Chip8& chip8_state, uint16_t& instruction, std::ofstream& stat
       case 1:
         //(1NNN) Jump to address NNN instruction
         chip8_state.PC = (instruction & 0x0FFF);
-        return true;
+        return CHIP8_RUNNING;
         break;
       case 2:
         //(2NNN) Execute subroutine at NNN
         if(chip8_state.SP < 16) {
           chip8_state.stack[chip8_state.SP++] = chip8_state.PC + 2;
           chip8_state.PC = (instruction & 0x0FFF);
-          return true;
+          return CHIP8_RUNNING;
         } else {
-          std::cerr << "Stack overflow\n";
-          cleanup(state_file);
-          exit(EXIT_FAILURE);
+          return CHIP8_STACK_OVERFLOW;
         }
         break;
       case 3:
         //(3XNN) Skip the following instruction if VX equals NN
         if (chip8_state.V[NIBBLE2] == (instruction & 0x00FF)) {
           chip8_state.PC += 4; //skip
-          return true;
+          return CHIP8_RUNNING;
         }
         break;
       case 4:
         //(4XNN) Skip the following instruction if VX does not equal NN
           if (chip8_state.V[NIBBLE2] != (instruction & 0x00FF)) {
             chip8_state.PC += 4; //skip
-            return true;
+            return CHIP8_RUNNING;
           }
         break;
       case 5:
         //(5XY0) Skip the following instruction if VX equals VY
           if (chip8_state.V[NIBBLE2] == chip8_state.V[NIBBLE1]) {
             chip8_state.PC += 4; //skip
-            return true;
+            return CHIP8_RUNNING;
           }
         break;
       case 6:
@@ -211,9 +245,7 @@ bool emulateCycle(Chip8& chip8_state, uint16_t& instruction, std::ofstream& stat
             break;
           }
           default:
-            std::cout << "Instruction not implemented or ROM error!" << std::endl;
-            cleanup(state_file);
-            exit(EXIT_FAILURE);
+            return CHIP8_UNKNOWN_INSTRUCTION;
         }
         //End of nested switch
         break;
@@ -221,7 +253,7 @@ bool emulateCycle(Chip8& chip8_state, uint16_t& instruction, std::ofstream& stat
         //(9XY0) Skip next instr if VX != VY
         if(chip8_state.V[NIBBLE2] != chip8_state.V[NIBBLE1]) {
           chip8_state.PC += 4;
-          return true;
+          return CHIP8_RUNNING;
         }
         break;
       case 0xA:
@@ -231,20 +263,20 @@ bool emulateCycle(Chip8& chip8_state, uint16_t& instruction, std::ofstream& stat
       case 0xB:
         //(BNNN): Jump to address NNN + V0
         chip8_state.PC = (instruction & 0x0FFF) + static_cast<uint16_t>(chip8_state.V[0]);
-        return true;
+        return CHIP8_RUNNING;
         break;
       case 0xC: {
         //(CXNN): Set VX to random number w/ mask of NN
-        std::random_device rd;
-        std::mt19937 gen(rd());
-        std::uniform_int_distribution<uint8_t> dist(0, 255);
-        chip8_state.V[NIBBLE2] = dist(gen) & static_cast<uint8_t>(instruction & 0x00FF);
+        std::uniform_int_distribution<int> dist(0, 255);
+        chip8_state.V[NIBBLE2] = static_cast<uint8_t>(dist(chip8_state.rng)) & static_cast<uint8_t>(instruction & 0x00FF);
         break;
       }
       case 0xD: {
         //(DXYN) Draw a sprite using XOR
         int x = chip8_state.V[NIBBLE2];
         int y = chip8_state.V[NIBBLE1];
+        if (static_cast<size_t>(chip8_state.I) + NIBBLE0 > MEM_SIZE)
+          return CHIP8_MEMORY_OUT_OF_BOUNDS;
         chip8_state.V[0xF] = 0; // VF is used for collision detection
 
         for (int row = 0; row < NIBBLE0; row++) {
@@ -270,23 +302,27 @@ bool emulateCycle(Chip8& chip8_state, uint16_t& instruction, std::ofstream& stat
       case 0xE: {
         if ((instruction & 0x00FF) == 0x9E) { //If key is pressed, skip next instr
           int key = chip8_state.V[NIBBLE2];
+          if (key > 0xF)
+            return CHIP8_INVALID_KEY;
           if (chip8_state.keypad[key]) {
             chip8_state.PC += 4;
-            return true;
+            return CHIP8_RUNNING;
           }
         }
         else if ((instruction & 0x00FF) == 0xA1) { //If key is NOT pressed, skip next instr
           int key = chip8_state.V[NIBBLE2];
+          if (key > 0xF)
+            return CHIP8_INVALID_KEY;
           if (!chip8_state.keypad[key]) {
             chip8_state.PC += 4;
-            return true;
+            return CHIP8_RUNNING;
           }
         }
         break;
       }
       case 0xF: {
         if(instruction == 0xFFFF) { //CUSTOM HALT INSTRUCTION
-          return (running = false);
+          return CHIP8_HALTED;
         }
         switch (instruction & 0x00FF) {
           case 0x07:
@@ -295,15 +331,15 @@ bool emulateCycle(Chip8& chip8_state, uint16_t& instruction, std::ofstream& stat
             break;
           case 0x0A: {
             //Wait for a keypress, store the result in VX
-            if ((key_pressed != -1) && chip8_state.keypad[key_pressed] == 0) {
-              key_pressed = -1;
+            if ((chip8_state.key_pressed != -1) && chip8_state.keypad[chip8_state.key_pressed] == 0) {
+              chip8_state.key_pressed = -1;
               break;
             }
 
             //bool keyPressed = false;
             for (uint8_t key = 0; key < 16; key++) {
               if (chip8_state.keypad[key]) {
-                key_pressed = key;
+                chip8_state.key_pressed = key;
                 chip8_state.V[NIBBLE2] = key;
                 //keyPressed = true;
                 break;
@@ -332,6 +368,8 @@ bool emulateCycle(Chip8& chip8_state, uint16_t& instruction, std::ofstream& stat
             break;
           case 0x33: {
             //Store BCD encoded version of VX into I, I+1, I+2
+            if (static_cast<size_t>(chip8_state.I) + 3 > MEM_SIZE)
+              return CHIP8_MEMORY_OUT_OF_BOUNDS;
             uint8_t val = chip8_state.V[NIBBLE2];
             chip8_state.mem[chip8_state.I] = val / 100;
             chip8_state.mem[chip8_state.I + 1] = (val / 10) % 10;
@@ -340,6 +378,8 @@ bool emulateCycle(Chip8& chip8_state, uint16_t& instruction, std::ofstream& stat
           }
           case 0x55:
             //Fill mem locations I,...,I+X with V0,...,VX, set I to I + X + 1
+            if (static_cast<size_t>(chip8_state.I) + (NIBBLE2) >= MEM_SIZE)
+              return CHIP8_MEMORY_OUT_OF_BOUNDS;
             for (int i = 0; i <= NIBBLE2; i++) {
               chip8_state.mem[chip8_state.I+i] = chip8_state.V[i];
             }
@@ -347,27 +387,25 @@ bool emulateCycle(Chip8& chip8_state, uint16_t& instruction, std::ofstream& stat
             break;
           case 0x65:
             //Fill V0 to VX with values stored at I, I+1, ..., set I to I + X + 1
+            if (static_cast<size_t>(chip8_state.I) + (NIBBLE2) >= MEM_SIZE)
+              return CHIP8_MEMORY_OUT_OF_BOUNDS;
             for (int i = 0; i <= NIBBLE2; i++) {
               chip8_state.V[i] = chip8_state.mem[chip8_state.I+i];
             }
             chip8_state.I = chip8_state.I + static_cast<uint16_t>(NIBBLE2) + 1;
             break;
           default:
-            std::cout << "Instruction not implemented or ROM error!" << std::endl;
-            cleanup(state_file);
-            exit(EXIT_FAILURE);
+            return CHIP8_UNKNOWN_INSTRUCTION;
         }
         break;
       }
       default:
-        std::cout << "Instruction not implemented or ROM error!" << std::endl;
-        cleanup(state_file);
-        exit(EXIT_FAILURE);
+        return CHIP8_UNKNOWN_INSTRUCTION;
     }
 
     //Increment instruction counter
     chip8_state.PC += 2;
 
 
-    return running;
+    return CHIP8_RUNNING;
 }
\ No newline at end of file
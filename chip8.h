@@ -9,6 +9,7 @@
 #include <random>
 #include <cstdlib>
 #include <cstring>
+#include <string>
 
 constexpr size_t MEM_SIZE = 4096;
 constexpr size_t loadAddress = 0x200; //CHIP-8 programs are usually loaded at address 0x200 (512)
@@ -22,6 +23,17 @@ constexpr int CHIP8_HEIGHT = 32;
 
 extern uint8_t chip8_fontset[80];
 
+//Result of emulating one cycle. Anything other than CHIP8_RUNNING means the program has stopped.
+enum Chip8Status {
+    CHIP8_RUNNING = 0,
+    CHIP8_HALTED,               //PC ran past the ROM or hit the custom FFFF halt instruction
+    CHIP8_STACK_OVERFLOW,
+    CHIP8_STACK_UNDERFLOW,
+    CHIP8_UNKNOWN_INSTRUCTION,
+    CHIP8_MEMORY_OUT_OF_BOUNDS, //I-relative access past the end of memory
+    CHIP8_INVALID_KEY           //EX9E/EXA1 with VX > 0xF
+};
+
 typedef struct Chip8 {
     // Memory
     uint8_t mem[MEM_SIZE];
@@ -48,7 +60,14 @@ typedef struct Chip8 {
     uint8_t delay_timer;
     uint8_t sound_timer;
 
-    Chip8() {
+    //Key latched by FX0A while waiting for its release (-1 if none)
+    int key_pressed;
+
+    //Random source for CXNN, kept per instance so seeded runs are reproducible.
+    //Seed it through std::seed_seq: minstd_rand streams from small raw seeds are strongly correlated
+    std::minstd_rand rng;
+
+    Chip8() : rng(std::random_device{}()) {
         // Clear all memory and registers
         std::memset(stack, 0, sizeof(stack));
         std::memset(keypad, 0, sizeof(keypad));
@@ -64,6 +83,7 @@ typedef struct Chip8 {
         SP = 0;             // Clear stack pointer
         delay_timer = 0;    // Initialize delay timer to 0
         sound_timer = 0;     // Initialize sound timer to 0
+        key_pressed = -1;
     }
 } Chip8;
 
@@ -73,7 +93,15 @@ void cleanup(std::ofstream& state_file);
 //Function to write the current state of the interpreter to a file dump
 void writeStateToFile(const Chip8& chip8_state, uint16_t instruction, std::ofstream& file);
 
-//Emulates a single cycle. Returns true the chip8 still had an instruction to execute this cycle; otherwise, false signals program end
-bool emulateCycle(Chip8& chip8_state, uint16_t& instruction, std::ofstream& state_file);
+//Loads the font and the ROM at rom_path into a freshly constructed state. Prints the reason and returns false on failure
+bool loadROM(Chip8& chip8_state, const std::string& rom_path);
+
+//Human readable description of a status code
+const char* chip8StatusString(Chip8Status status);
+
+//Emulates a single cycle. The state dump is skipped when state_file is not open.
+//Returns CHIP8_RUNNING if the chip8 still had an instruction to execute this cycle; otherwise, the reason it stopped.
+//On error the state is left as it was before the faulting instruction.
+Chip8Status emulateCycle(Chip8& chip8_state, uint16_t& instruction, std::ofstream& state_file);
 
 #endif //CHIP8_H
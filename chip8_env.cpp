@@ -0,0 +1,225 @@
+#include "chip8_env.h"
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <algorithm>
+
+#include "chip8.h"
+
+struct RewardHook {
+  uint16_t addr;
+  float scale;
+};
+
+struct Chip8Env {
+  //Freshly loaded machine (font + ROM) that every reset copies from
+  Chip8 initial;
+  std::vector<Chip8> instances;
+  std::vector<uint8_t> done;
+  std::vector<RewardHook> hooks;
+  int frames_per_step;
+  int cycles_per_frame;
+
+  //Arguments of the step currently being run by the workers
+  const uint16_t* actions;
+  float* rewards;
+
+  //Worker pool: thread 0 is the caller, threads 1..num_threads-1 wait for a new generation
+  int num_threads;
+  std::vector<std::thread> workers;
+  std::mutex mtx;
+  std::condition_variable work_cv;
+  std::condition_variable done_cv;
+  uint64_t generation;
+  int pending;
+  bool shutting_down;
+};
+
+//Runs one step for instances [begin, end)
+static void stepRange(Chip8Env& env, int begin, int end) {
+  std::ofstream no_dump; //never opened, so emulateCycle skips the state dump
+  uint16_t instruction;
+  for (int i = begin; i < end; i++) {
+    Chip8& chip8_state = env.instances[i];
+    float reward = 0.0f;
+
+    if (!env.done[i]) {
+      uint16_t mask = env.actions ? env.actions[i] : 0;
+      for (int key = 0; key < 16; key++) {
+        chip8_state.keypad[key] = (mask >> key) & 1;
+      }
+
+      for (const RewardHook& hook : env.hooks) {
+        reward -= hook.scale * chip8_state.mem[hook.addr];
+      }
+
+      for (int frame = 0; frame < env.frames_per_step && !env.done[i]; frame++) {
+        for (int cycle = 0; cycle < env.cycles_per_frame; cycle++) {
+          Chip8Status status = emulateCycle(chip8_state, instruction, no_dump);
+          if (status != CHIP8_RUNNING) {
+            env.done[i] = static_cast<uint8_t>(status);
+            break;
+          }
+        }
+        if (chip8_state.delay_timer > 0) chip8_state.delay_timer--;
+        if (chip8_state.sound_timer > 0) chip8_state.sound_timer--;
+      }
+
+      for (const RewardHook& hook : env.hooks) {
+        reward += hook.scale * chip8_state.mem[hook.addr];
+      }
+    }
+
+    if (env.rewards) env.rewards[i] = reward;
+  }
+}
+
+//Splits the instances into one contiguous chunk per thread
+static void chunkBounds(const Chip8Env& env, int thread_id, int& begin, int& end) {
+  int n = static_cast<int>(env.instances.size());
+  begin = static_cast<int>(static_cast<int64_t>(n) * thread_id / env.num_threads);
+  end = static_cast<int>(static_cast<int64_t>(n) * (thread_id + 1) / env.num_threads);
+}
+
+static void workerLoop(Chip8Env* env, int thread_id) {
+  uint64_t seen = 0;
+  while (true) {
+    {
+      std::unique_lock<std::mutex> lock(env->mtx);
+      env->work_cv.wait(lock, [&] { return env->shutting_down || env->generation != seen; });
+      if (env->shutting_down) return;
+      seen = env->generation;
+    }
+
+    int begin, end;
+    chunkBounds(*env, thread_id, begin, end);
+    stepRange(*env, begin, end);
+
+    {
+      std::lock_guard<std::mutex> lock(env->mtx);
+      if (--env->pending == 0) env->done_cv.notify_one();
+    }
+  }
+}
+
+static void resetInstance(Chip8Env& env, int index, uint64_t seed) {
+  env.instances[index] = env.initial;
+  //seed_seq scrambles the seed so neighbouring seeds (e.g. 0..N-1) give unrelated streams
+  std::seed_seq seq{static_cast<uint32_t>(seed), static_cast<uint32_t>(seed >> 32)};
+  env.instances[index].rng.seed(seq);
+  env.done[index] = 0;
+}
+
+extern "C" {
+
+Chip8Env* chip8_env_create(const char* rom_path, int num_envs, int frames_per_step,
+                           int cycles_per_frame, int num_threads) {
+  if (!rom_path || num_envs <= 0 || frames_per_step <= 0 || cycles_per_frame <= 0) {
+    std::cerr << "chip8_env_create: invalid arguments\n";
+    return nullptr;
+  }
+
+  Chip8Env* env = new Chip8Env();
+  if (!loadROM(env->initial, rom_path)) {
+    delete env;
+    return nullptr;
+  }
+
+  env->instances.assign(num_envs, env->initial);
+  env->done.assign(num_envs, 0);
+  env->frames_per_step = frames_per_step;
+  env->cycles_per_frame = cycles_per_frame;
+  env->actions = nullptr;
+  env->rewards = nullptr;
+  env->generation = 0;
+  env->pending = 0;
+  env->shutting_down = false;
+
+  if (num_threads <= 0) {
+    num_threads = std::max(1u, std::thread::hardware_concurrency());
+  }
+  num_threads = std::min(num_threads, num_envs);
+  env->num_threads = num_threads;
+  for (int t = 1; t < num_threads; t++) {
+    env->workers.emplace_back(workerLoop, env, t);
+  }
+
+  return env;
+}
+
+void chip8_env_destroy(Chip8Env* env) {
+  if (!env) return;
+  {
+    std::lock_guard<std::mutex> lock(env->mtx);
+    env->shutting_down = true;
+  }
+  env->work_cv.notify_all();
+  for (std::thread& worker : env->workers) {
+    worker.join();
+  }
+  delete env;
+}
+
+int chip8_env_num_envs(const Chip8Env* env) {
+  return static_cast<int>(env->instances.size());
+}
+
+int chip8_env_add_reward_hook(Chip8Env* env, uint16_t addr, float scale) {
+  if (addr >= MEM_SIZE) return -1;
+  env->hooks.push_back({addr, scale});
+  return 0;
+}
+
+void chip8_env_reset(Chip8Env* env, const uint64_t* seeds) {
+  std::random_device rd;
+  for (int i = 0; i < static_cast<int>(env->instances.size()); i++) {
+    resetInstance(*env, i, seeds ? seeds[i] : (static_cast<uint64_t>(rd()) << 32) | rd());
+  }
+}
+
+void chip8_env_reset_one(Chip8Env* env, int index, uint64_t seed) {
+  if (index < 0 || index >= static_cast<int>(env->instances.size())) return;
+  resetInstance(*env, index, seed);
+}
+
+void chip8_env_step(Chip8Env* env, const uint16_t* actions, float* rewards, uint8_t* dones) {
+  env->actions = actions;
+  env->rewards = rewards;
+
+  if (!env->workers.empty()) {
+    std::lock_guard<std::mutex> lock(env->mtx);
+    env->pending = static_cast<int>(env->workers.size());
+    env->generation++;
+  }
+  env->work_cv.notify_all();
+
+  int begin, end;
+  chunkBounds(*env, 0, begin, end);
+  stepRange(*env, begin, end);
+
+  if (!env->workers.empty()) {
+    std::unique_lock<std::mutex> lock(env->mtx);
+    env->done_cv.wait(lock, [&] { return env->pending == 0; });
+  }
+
+  if (dones) {
+    std::copy(env->done.begin(), env->done.end(), dones);
+  }
+}
+
+const uint8_t* chip8_env_observations(const Chip8Env* env) {
+  return env->instances[0].gfx;
+}
+
+size_t chip8_env_observation_stride(void) {
+  return sizeof(Chip8);
+}
+
+const uint8_t* chip8_env_memory(const Chip8Env* env, int index) {
+  if (index < 0 || index >= static_cast<int>(env->instances.size())) return nullptr;
+  return env->instances[index].mem;
+}
+
+} //extern "C"
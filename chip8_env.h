@@ -0,0 +1,60 @@
+#ifndef CHIP8_ENV_H
+#define CHIP8_ENV_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+//Batched reset/step interface over many independent Chip8 instances sharing one ROM.
+//Plain C linkage so the shared library can be loaded from other languages (e.g. Python ctypes).
+
+#ifdef _WIN32
+#define CHIP8_ENV_API __declspec(dllexport)
+#else
+#define CHIP8_ENV_API __attribute__((visibility("default")))
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct Chip8Env Chip8Env;
+
+//Creates num_envs instances of the ROM at rom_path. Each step runs frames_per_step frames of
+//cycles_per_frame instructions, decrementing the timers once per frame like the windowed build.
+//num_threads <= 0 uses the hardware concurrency. Returns NULL on failure.
+CHIP8_ENV_API Chip8Env* chip8_env_create(const char* rom_path, int num_envs, int frames_per_step,
+                                         int cycles_per_frame, int num_threads);
+
+CHIP8_ENV_API void chip8_env_destroy(Chip8Env* env);
+
+CHIP8_ENV_API int chip8_env_num_envs(const Chip8Env* env);
+
+//Adds a reward hook: each step, reward += scale * (mem[addr] after step - mem[addr] before step).
+//Returns 0 on success, -1 if addr is out of range.
+CHIP8_ENV_API int chip8_env_add_reward_hook(Chip8Env* env, uint16_t addr, float scale);
+
+//Resets every instance. seeds may be NULL (non-deterministic CXNN) or hold num_envs seeds.
+CHIP8_ENV_API void chip8_env_reset(Chip8Env* env, const uint64_t* seeds);
+
+//Resets a single instance, e.g. after it reports done.
+CHIP8_ENV_API void chip8_env_reset_one(Chip8Env* env, int index, uint64_t seed);
+
+//Advances every instance that is not done. actions holds one 16-bit keypad mask per instance
+//(bit k set = key k held). rewards and dones are written per instance; either may be NULL.
+//An instance is done once its program stops; dones then holds the nonzero Chip8Status
+//(1 = halted normally, larger values are ROM errors such as stack overflow).
+CHIP8_ENV_API void chip8_env_step(Chip8Env* env, const uint16_t* actions, float* rewards, uint8_t* dones);
+
+//Zero-copy observations: instance i's 64x32 framebuffer (one byte per pixel) starts at
+//chip8_env_observations(env) + i * chip8_env_observation_stride(). Valid until destroy.
+CHIP8_ENV_API const uint8_t* chip8_env_observations(const Chip8Env* env);
+CHIP8_ENV_API size_t chip8_env_observation_stride(void);
+
+//Direct read access to an instance's memory, for reward or debugging code outside the hooks.
+CHIP8_ENV_API const uint8_t* chip8_env_memory(const Chip8Env* env, int index);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //CHIP8_ENV_H
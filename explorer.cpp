@@ -0,0 +1,554 @@
+#include <vector>
+#include <deque>
+#include <map>
+#include <array>
+#include <unordered_map>
+#include <mutex>
+#include <thread>
+#include <atomic>
+#include <condition_variable>
+#include <algorithm>
+
+#include "chip8.h"
+
+//Explores every execution of a ROM by forking the interpreter state wherever the program reads input
+//(FX0A, EX9E, EXA1) or draws a random number (CXNN). Between those points execution is deterministic,
+//so snapshots are only hashed and deduplicated at decision points. A state is expanded again whenever it
+//is reached by a path with fewer decisions, so reported error paths are the shortest within --max-depth.
+
+//One choice made at a decision point
+struct Decision {
+  uint16_t pc;
+  uint16_t instruction;
+  uint8_t value; //key pressed (FX0A), key held 0/1 (EX9E/EXA1), or value drawn (CXNN)
+};
+
+//Interpreter state saved at a decision point. Chip8's rng is left out because CXNN is forked instead of
+//drawn, and the keypad is always released between decisions.
+struct Snapshot {
+  uint8_t mem[MEM_SIZE];
+  uint8_t gfx[CHIP8_WIDTH * CHIP8_HEIGHT];
+  uint16_t stack[16];
+  uint8_t V[16];
+  uint16_t PC;
+  uint16_t I;
+  uint8_t SP;
+  uint8_t delay_timer;
+  uint8_t sound_timer;
+  int key_pressed;
+  int frame_cycle; //cycles already run in the current 60Hz frame, timers tick when it wraps
+};
+
+//An open decision whose branches are claimed one at a time while it stays queued, so the frontier holds
+//one snapshot per decision rather than one per branch. The root task has no decision and just runs.
+struct Task {
+  uint64_t id;                //identifies the snapshot to workers that restored it before
+  Snapshot state;
+  std::vector<Decision> path; //decisions taken to reach state
+  uint16_t instruction;       //decision instruction at state.PC
+  int next_choice;            //branch to explore next, -1 for the root task
+};
+
+struct ErrorReport {
+  Chip8Status status;
+  uint16_t pc;
+  uint16_t instruction;
+  std::vector<Decision> path;
+};
+
+struct ExploreConfig {
+  int threads;
+  uint64_t max_states;         //distinct decision states to expand before giving up
+  uint64_t max_segment_cycles; //cycles to run between decisions before calling the path a timeout
+  size_t max_depth;            //decisions along one path before it is cut off
+  int cycles_per_frame;
+};
+
+//Per worker results, merged once exploration is finished
+struct WorkerResult {
+  std::vector<uint8_t> covered = std::vector<uint8_t>(MEM_SIZE, 0); //addresses executed as instructions
+  std::map<std::pair<int, uint16_t>, ErrorReport> errors;          //shortest path per (status, PC)
+  uint64_t halted = 0;
+  uint64_t timeouts = 0;
+  uint64_t depth_limited = 0;
+  uint64_t duplicates = 0;
+};
+
+struct WorkQueue {
+  std::mutex mtx;
+  std::deque<Task> tasks;
+};
+
+struct VisitedShard {
+  std::mutex mtx;
+  std::unordered_map<uint64_t, uint16_t> min_depth; //fewest decisions any expanded path needed to reach the state
+};
+
+struct Explorer {
+  ExploreConfig config;
+  std::streamsize rom_size;
+  std::vector<WorkQueue> queues;
+  std::array<VisitedShard, 64> visited;
+  std::atomic<int64_t> outstanding{0}; //open decisions queued plus branches being run
+  std::atomic<uint64_t> states{0}; //expansions, including re-expansions at a shallower depth
+  std::atomic<uint64_t> next_task_id{1};
+  std::atomic<bool> budget_hit{false};
+
+  //Idle workers sleep here until a task is queued or everything is finished
+  std::mutex idle_mtx;
+  std::condition_variable idle_cv;
+  std::atomic<int64_t> queued{0}; //open decisions sitting in any queue
+
+  Explorer(const ExploreConfig& cfg, std::streamsize size) : config(cfg), rom_size(size), queues(cfg.threads) {}
+};
+
+static uint64_t mixBytes(uint64_t h, const void* data, size_t len) {
+  const uint8_t* bytes = static_cast<const uint8_t*>(data);
+  size_t i = 0;
+  for (; i + 8 <= len; i += 8) {
+    uint64_t word;
+    std::memcpy(&word, bytes + i, 8);
+    h = (h ^ word) * 0x9E3779B97F4A7C15ULL;
+    h ^= h >> 32;
+  }
+  for (; i < len; i++) {
+    h = (h ^ bytes[i]) * 0x100000001B3ULL;
+  }
+  return h;
+}
+
+//Hash of everything that affects future execution. The keypad is always released at decision
+//points and the RNG is replaced by forking, so neither is included.
+static uint64_t hashState(const Chip8& s, int frame_cycle) {
+  uint64_t h = 0xCBF29CE484222325ULL;
+  h = mixBytes(h, s.mem, sizeof(s.mem));
+  h = mixBytes(h, s.gfx, sizeof(s.gfx));
+  h = mixBytes(h, s.stack, sizeof(s.stack));
+  h = mixBytes(h, s.V, sizeof(s.V));
+  uint16_t regs[8] = {s.PC, s.I, s.SP, s.delay_timer, s.sound_timer,
+                      static_cast<uint16_t>(s.key_pressed), static_cast<uint16_t>(frame_cycle), 0};
+  return mixBytes(h, regs, sizeof(regs));
+}
+
+static void saveSnapshot(const Chip8& s, int frame_cycle, Snapshot& snap) {
+  std::memcpy(snap.mem, s.mem, sizeof(snap.mem));
+  std::memcpy(snap.gfx, s.gfx, sizeof(snap.gfx));
+  std::memcpy(snap.stack, s.stack, sizeof(snap.stack));
+  std::memcpy(snap.V, s.V, sizeof(snap.V));
+  snap.PC = s.PC;
+  snap.I = s.I;
+  snap.SP = s.SP;
+  snap.delay_timer = s.delay_timer;
+  snap.sound_timer = s.sound_timer;
+  snap.key_pressed = s.key_pressed;
+  snap.frame_cycle = frame_cycle;
+}
+
+//A worker's interpreter that snapshots are restored into. mem and gfx make up nearly all of a snapshot,
+//so they are only recopied when a different snapshot is loaded or the last branch wrote to them.
+struct Scratch {
+  Chip8 state;
+  int frame_cycle = 0;
+  uint64_t task_id = 0; //Task::id last restored, 0 if none
+  bool mem_dirty = true;
+  bool gfx_dirty = true;
+};
+
+static void restoreSnapshot(const Task& task, Scratch& scratch) {
+  const Snapshot& snap = task.state;
+  Chip8& s = scratch.state;
+  if (scratch.task_id != task.id || scratch.mem_dirty) std::memcpy(s.mem, snap.mem, sizeof(snap.mem));
+  if (scratch.task_id != task.id || scratch.gfx_dirty) std::memcpy(s.gfx, snap.gfx, sizeof(snap.gfx));
+  scratch.task_id = task.id;
+  scratch.mem_dirty = false;
+  scratch.gfx_dirty = false;
+  std::memcpy(s.stack, snap.stack, sizeof(snap.stack));
+  std::memcpy(s.V, snap.V, sizeof(snap.V));
+  std::memset(s.keypad, 0, sizeof(s.keypad));
+  s.PC = snap.PC;
+  s.I = snap.I;
+  s.SP = snap.SP;
+  s.delay_timer = snap.delay_timer;
+  s.sound_timer = snap.sound_timer;
+  s.key_pressed = snap.key_pressed;
+  scratch.frame_cycle = snap.frame_cycle;
+}
+
+//Returns true if the state has not been expanded yet at this depth or a shallower one
+static bool markVisited(Explorer& explorer, uint64_t hash, uint16_t depth) {
+  VisitedShard& shard = explorer.visited[hash % explorer.visited.size()];
+  std::lock_guard<std::mutex> lock(shard.mtx);
+  auto [it, inserted] = shard.min_depth.emplace(hash, depth);
+  if (inserted) return true;
+  if (depth >= it->second) return false;
+  it->second = depth;
+  return true;
+}
+
+//Advances the frame clock by one cycle, ticking the timers like main's 60Hz loop
+static void tick(Chip8& s, int& frame_cycle, int cycles_per_frame) {
+  if (++frame_cycle < cycles_per_frame) return;
+  frame_cycle = 0;
+  if (s.delay_timer > 0) s.delay_timer--;
+  if (s.sound_timer > 0) s.sound_timer--;
+}
+
+//EX9E/EXA1 with VX > 0xF is not a decision: emulateCycle rejects it as CHIP8_INVALID_KEY
+static bool isDecision(const Chip8& s, uint16_t instruction) {
+  uint16_t low = instruction & 0x00FF;
+  switch ((instruction & 0xF000) >> 12) {
+    case 0xC: return true;
+    case 0xE: return (low == 0x9E || low == 0xA1) && s.V[(instruction & 0x0F00) >> 8] <= 0xF;
+    case 0xF: return low == 0x0A && instruction != 0xFFFF;
+    default: return false;
+  }
+}
+
+static void push(Explorer& explorer, int thread_id, Task&& task) {
+  explorer.outstanding.fetch_add(1);
+  {
+    WorkQueue& queue = explorer.queues[thread_id];
+    std::lock_guard<std::mutex> lock(queue.mtx);
+    queue.tasks.push_back(std::move(task));
+  }
+  {
+    //Taking idle_mtx orders the increment against a worker's check-then-wait, so no wakeup is lost
+    std::lock_guard<std::mutex> lock(explorer.idle_mtx);
+    explorer.queued.fetch_add(1);
+  }
+  explorer.idle_cv.notify_one();
+}
+
+//Branch values of a decision: every value the CXNN mask lets through (NN down to 0), key not held/held
+//for EX9E/EXA1, and each key pressed for FX0A (waiting forever is not a distinct outcome)
+static int firstChoice(uint16_t instruction) {
+  return (instruction & 0xF000) == 0xC000 ? (instruction & 0x00FF) : 0;
+}
+
+//Returns -1 once every branch has been handed out
+static int nextChoice(uint16_t instruction, int choice) {
+  switch ((instruction & 0xF000) >> 12) {
+    case 0xC: return choice == 0 ? -1 : (choice - 1) & (instruction & 0x00FF);
+    case 0xE: return choice == 0 ? 1 : -1;
+    default: return choice < 15 ? choice + 1 : -1;
+  }
+}
+
+static uint64_t branchCount(uint16_t instruction) {
+  switch ((instruction & 0xF000) >> 12) {
+    case 0xC: return uint64_t{1} << __builtin_popcount(instruction & 0x00FF);
+    case 0xE: return 2;
+    default: return 16;
+  }
+}
+
+//Executes the decision instruction at the scratch PC with the given branch taken. None of these write mem or gfx.
+static void applyChoice(Scratch& scratch, uint16_t instruction, int choice, int cycles_per_frame,
+                        std::ofstream& no_dump) {
+  Chip8& s = scratch.state;
+  int& frame_cycle = scratch.frame_cycle;
+  const int x = (instruction & 0x0F00) >> 8;
+  uint16_t executed;
+
+  if ((instruction & 0xF000) == 0xC000) {
+    s.V[x] = static_cast<uint8_t>(choice);
+    s.PC += 2;
+    tick(s, frame_cycle, cycles_per_frame);
+  } else if ((instruction & 0xF000) == 0xE000) {
+    const int key = s.V[x];
+    s.keypad[key] = static_cast<uint8_t>(choice);
+    emulateCycle(s, executed, no_dump);
+    s.keypad[key] = 0;
+    tick(s, frame_cycle, cycles_per_frame);
+  } else {
+    //FX0A: press, then release on the next cycle
+    s.keypad[choice] = 1;
+    emulateCycle(s, executed, no_dump);
+    tick(s, frame_cycle, cycles_per_frame);
+    s.keypad[choice] = 0;
+    emulateCycle(s, executed, no_dump);
+    tick(s, frame_cycle, cycles_per_frame);
+  }
+}
+
+static void recordError(WorkerResult& result, const std::vector<Decision>& path, uint16_t pc, Chip8Status status,
+                        uint16_t instruction) {
+  auto key = std::make_pair(static_cast<int>(status), pc);
+  auto it = result.errors.find(key);
+  if (it == result.errors.end() || path.size() < it->second.path.size()) {
+    result.errors[key] = ErrorReport{status, pc, instruction, path};
+  }
+}
+
+//Queues the decision instruction at s.PC as an open decision, unless its branches would exceed
+//--max-depth or the state has already been expanded at this depth or a shallower one
+static void openDecision(Explorer& explorer, int thread_id, const Chip8& s, int frame_cycle,
+                         const std::vector<Decision>& path, uint16_t instruction, WorkerResult& result) {
+  if (path.size() + 1 > explorer.config.max_depth) {
+    result.depth_limited += branchCount(instruction);
+    return;
+  }
+  if (!markVisited(explorer, hashState(s, frame_cycle), static_cast<uint16_t>(path.size()))) {
+    result.duplicates++;
+    return;
+  }
+  if (explorer.states.fetch_add(1) >= explorer.config.max_states) {
+    explorer.budget_hit = true;
+    return;
+  }
+
+  Task task;
+  task.id = explorer.next_task_id.fetch_add(1);
+  saveSnapshot(s, frame_cycle, task.state);
+  task.path = path;
+  task.instruction = instruction;
+  task.next_choice = firstChoice(instruction);
+  push(explorer, thread_id, std::move(task));
+}
+
+//Runs deterministically until the next decision point or until the program stops
+static void runSegment(Explorer& explorer, int thread_id, Scratch& scratch,
+                       const std::vector<Decision>& path, WorkerResult& result, std::ofstream& no_dump) {
+  Chip8& s = scratch.state;
+  int& frame_cycle = scratch.frame_cycle;
+  uint16_t instruction = 0;
+
+  for (uint64_t n = 0; n < explorer.config.max_segment_cycles; n++) {
+    if (s.PC < loadAddress + s.romSize && static_cast<size_t>(s.PC) + 1 < MEM_SIZE) {
+      instruction = (s.mem[s.PC] << 8) | s.mem[s.PC + 1];
+      result.covered[s.PC] = 1;
+
+      //A jump to itself is the usual way a ROM ends
+      if (instruction == (0x1000 | s.PC)) {
+        result.halted++;
+        return;
+      }
+      if (isDecision(s, instruction)) {
+        openDecision(explorer, thread_id, s, frame_cycle, path, instruction, result);
+        return;
+      }
+    } else {
+      instruction = 0; //nothing to fetch, emulateCycle stops before reading memory
+    }
+
+    //The only instructions that write mem (FX33, FX55) or gfx (00E0, DXYN)
+    if ((instruction & 0xF0FF) == 0xF033 || (instruction & 0xF0FF) == 0xF055) scratch.mem_dirty = true;
+    if ((instruction & 0xF000) == 0xD000 || instruction == 0x00E0) scratch.gfx_dirty = true;
+
+    Chip8Status status = emulateCycle(s, instruction, no_dump);
+    if (status == CHIP8_HALTED) {
+      result.halted++;
+      return;
+    }
+    if (status != CHIP8_RUNNING) {
+      recordError(result, path, s.PC, status, instruction);
+      return;
+    }
+    tick(s, frame_cycle, explorer.config.cycles_per_frame);
+  }
+  result.timeouts++;
+}
+
+//A branch claimed from a queue; its snapshot has already been restored into the worker's scratch state
+struct Claim {
+  std::vector<Decision> path; //decisions up to and including this branch
+  uint16_t instruction;
+  int choice;                 //-1 for the root task
+  bool skip;                  //budget spent, nothing to run
+};
+
+//Claims the next branch of the newest open decision in this worker's queue (depth first), or of the oldest
+//one in another queue (largest remaining subtree). A decision leaves its queue once its last branch is claimed.
+static bool claimBranch(Explorer& explorer, int thread_id, Scratch& scratch, Claim& claim) {
+  int threads = static_cast<int>(explorer.queues.size());
+  for (int n = 0; n < threads; n++) {
+    int victim = (thread_id + n) % threads;
+    WorkQueue& queue = explorer.queues[victim];
+    std::lock_guard<std::mutex> lock(queue.mtx);
+    if (queue.tasks.empty()) continue;
+
+    const bool own = victim == thread_id;
+    Task& task = own ? queue.tasks.back() : queue.tasks.front();
+    bool exhausted = true;
+    claim.skip = explorer.budget_hit;
+    if (!claim.skip) {
+      restoreSnapshot(task, scratch);
+      claim.path = task.path;
+      claim.instruction = task.instruction;
+      claim.choice = task.next_choice;
+      if (claim.choice >= 0) {
+        claim.path.push_back({task.state.PC, task.instruction, static_cast<uint8_t>(claim.choice)});
+        task.next_choice = nextChoice(task.instruction, claim.choice);
+        exhausted = task.next_choice < 0;
+      }
+    }
+
+    if (exhausted) {
+      //The decision's outstanding count passes to the branch being claimed
+      if (own) queue.tasks.pop_back();
+      else queue.tasks.pop_front();
+      explorer.queued.fetch_sub(1);
+    } else {
+      explorer.outstanding.fetch_add(1);
+    }
+    return true;
+  }
+  return false;
+}
+
+static void workerLoop(Explorer& explorer, int thread_id, WorkerResult& result) {
+  std::ofstream no_dump; //never opened, so emulateCycle skips the state dump
+  Scratch scratch;
+  scratch.state.romSize = explorer.rom_size;
+  Claim claim;
+  while (true) {
+    if (!claimBranch(explorer, thread_id, scratch, claim)) {
+      std::unique_lock<std::mutex> lock(explorer.idle_mtx);
+      explorer.idle_cv.wait(lock, [&] { return explorer.queued.load() > 0 || explorer.outstanding.load() == 0; });
+      if (explorer.outstanding.load() == 0) return;
+      continue;
+    }
+    //Once the budget is spent the remaining queue is drained without running it
+    if (!claim.skip) {
+      if (claim.choice >= 0) {
+        applyChoice(scratch, claim.instruction, claim.choice, explorer.config.cycles_per_frame, no_dump);
+      }
+      runSegment(explorer, thread_id, scratch, claim.path, result, no_dump);
+    }
+    if (explorer.outstanding.fetch_sub(1) == 1) {
+      std::lock_guard<std::mutex> lock(explorer.idle_mtx);
+      explorer.idle_cv.notify_all();
+    }
+  }
+}
+
+static void printPath(const std::vector<Decision>& path) {
+  if (path.empty()) {
+    std::cout << "    (no input needed)\n";
+    return;
+  }
+  for (const Decision& d : path) {
+    std::cout << "    0x" << std::setw(3) << d.pc << " " << std::setw(4) << d.instruction << ": ";
+    if ((d.instruction & 0xF000) == 0xC000)
+      std::cout << "random -> 0x" << std::setw(2) << static_cast<int>(d.value) << "\n";
+    else if ((d.instruction & 0xF000) == 0xE000)
+      std::cout << (d.value ? "key held" : "key not held") << "\n";
+    else
+      std::cout << "press key " << static_cast<int>(d.value) << "\n";
+  }
+}
+
+int main(int argc, char* argv[]) {
+  const char* usage = "Usage: chip8_explore <path_to_rom> [--threads N] [--max-states N] [--max-cycles N] [--max-depth N] [--cycles-per-frame N]\n";
+  if (argc < 2) {
+    std::cerr << usage;
+    exit(EXIT_FAILURE);
+  }
+
+  std::string rom_path(argv[1]);
+  ExploreConfig config{static_cast<int>(std::max(1u, std::thread::hardware_concurrency())), 1000000, 100000, 256, 12};
+
+  for (int i = 2; i < argc; i += 2) {
+    std::string flag(argv[i]);
+    if (i + 1 >= argc) {
+      std::cerr << usage;
+      exit(EXIT_FAILURE);
+    }
+    unsigned long long value = std::strtoull(argv[i + 1], nullptr, 10);
+    if (flag == "--threads") config.threads = static_cast<int>(value);
+    else if (flag == "--max-states") config.max_states = value;
+    else if (flag == "--max-cycles") config.max_segment_cycles = value;
+    else if (flag == "--max-depth") config.max_depth = std::min<unsigned long long>(value, UINT16_MAX);
+    else if (flag == "--cycles-per-frame") config.cycles_per_frame = static_cast<int>(value);
+    else {
+      std::cerr << usage;
+      exit(EXIT_FAILURE);
+    }
+  }
+  if (config.threads <= 0 || config.cycles_per_frame <= 0) {
+    std::cerr << usage;
+    exit(EXIT_FAILURE);
+  }
+
+  Chip8 initial;
+  if (!loadROM(initial, rom_path)) {
+    exit(EXIT_FAILURE);
+  }
+  const size_t rom_end = loadAddress + static_cast<size_t>(initial.romSize);
+
+  Explorer explorer(config, initial.romSize);
+  Task root;
+  root.id = explorer.next_task_id.fetch_add(1);
+  saveSnapshot(initial, 0, root.state);
+  root.instruction = 0;
+  root.next_choice = -1;
+  push(explorer, 0, std::move(root));
+
+  std::vector<WorkerResult> results(config.threads);
+  std::vector<std::thread> workers;
+  for (int t = 1; t < config.threads; t++) {
+    workers.emplace_back(workerLoop, std::ref(explorer), t, std::ref(results[t]));
+  }
+  workerLoop(explorer, 0, results[0]);
+  for (std::thread& worker : workers) {
+    worker.join();
+  }
+
+  //Merge worker results
+  WorkerResult total;
+  for (const WorkerResult& result : results) {
+    for (size_t addr = 0; addr < MEM_SIZE; addr++) {
+      total.covered[addr] |= result.covered[addr];
+    }
+    for (const auto& [key, report] : result.errors) {
+      auto it = total.errors.find(key);
+      if (it == total.errors.end() || report.path.size() < it->second.path.size()) {
+        total.errors[key] = report;
+      }
+    }
+    total.halted += result.halted;
+    total.timeouts += result.timeouts;
+    total.depth_limited += result.depth_limited;
+    total.duplicates += result.duplicates;
+  }
+
+  std::cout << "Expanded " << std::min(explorer.states.load(), config.max_states) << " decision states ("
+            << total.duplicates << " duplicates skipped)";
+  if (explorer.budget_hit) std::cout << ", state budget reached";
+  std::cout << "\n";
+  std::cout << "Paths halted: " << total.halted << ", timed out: " << total.timeouts
+            << ", cut at max depth: " << total.depth_limited << "\n";
+
+  //An executed instruction covers both of its bytes
+  std::vector<uint8_t> rom_covered(MEM_SIZE, 0);
+  for (size_t addr = 0; addr + 1 < MEM_SIZE; addr++) {
+    if (total.covered[addr]) rom_covered[addr] = rom_covered[addr + 1] = 1;
+  }
+  size_t covered_bytes = 0;
+  for (size_t addr = loadAddress; addr < rom_end; addr++) {
+    covered_bytes += rom_covered[addr];
+  }
+  size_t rom_bytes = rom_end - loadAddress;
+  std::cout << "Coverage: " << covered_bytes << " of " << rom_bytes << " ROM bytes executed ("
+            << std::fixed << std::setprecision(1) << (rom_bytes ? 100.0 * covered_bytes / rom_bytes : 0.0) << "%)\n";
+
+  std::cout << std::hex << std::uppercase << std::setfill('0');
+  for (size_t addr = loadAddress; addr < rom_end;) {
+    if (rom_covered[addr]) {
+      addr++;
+      continue;
+    }
+    size_t start = addr;
+    while (addr < rom_end && !rom_covered[addr]) addr++;
+    std::cout << "  not executed: 0x" << std::setw(3) << start << "-0x" << std::setw(3) << addr - 1 << "\n";
+  }
+
+  std::cout << std::dec << "Errors: " << total.errors.size() << "\n" << std::hex;
+  for (const auto& [key, report] : total.errors) {
+    std::cout << "  " << chip8StatusString(report.status) << " at PC 0x" << std::setw(3) << report.pc
+              << " (instruction 0x" << std::setw(4) << report.instruction << "), reached by:\n";
+    printPath(report.path);
+  }
+
+  return total.errors.empty() ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -40,11 +40,6 @@ int main(int argc, char* argv[]) {
   std::cout << "Loading ROM: " << rom_path << std::endl;
   Chip8 chip8_state;
 
-  //Load in Chip-8 Font Data
-  for (int i = 0; i < 80; i++) {
-    chip8_state.mem[0x050 + i] = chip8_fontset[i];
-  }
-
   //Set up chip8_state dump file
   std::filesystem::path path(rom_path);
   std::filesystem::path chip8_state_dump_path = path.parent_path().parent_path() / "chip8_state_dump" / (path.stem().string() + "_statedump.txt");
@@ -54,27 +49,8 @@ int main(int argc, char* argv[]) {
     std::cerr << "Unable to open debugger (dump) file for writing\n";
   }
 
-  //Load in ROM binary into file handle
-  std::ifstream rom(rom_path, std::ios::binary | std::ios::ate);
-  if (!rom) {
-    std::cerr << "Error: Could not open ROM file: " << rom_path << std::endl;
-    exit(EXIT_FAILURE);
-  }
-
-  //Get file size
-  chip8_state.romSize = rom.tellg();
-  rom.seekg(0, std::ios::beg);
-
-  //Check ROM size
-  if (chip8_state.romSize > static_cast<std::streamsize>(MEM_SIZE - loadAddress)) {
-    std::cerr << "Error: ROM file is too large to fit in memory." << std::endl;
-    cleanup(state_file);
-    exit(EXIT_FAILURE);
-  }
-
-  //Read the ROM into the virtual memory array starting at address 0x200
-  if (!rom.read(reinterpret_cast<char*>(&chip8_state.mem[loadAddress]), chip8_state.romSize)) {
-    std::cerr << "Error reading ROM file." << std::endl;
+  //Load the font and the ROM binary into virtual memory (ROM starts at address 0x200)
+  if (!loadROM(chip8_state, rom_path)) {
     cleanup(state_file);
     exit(EXIT_FAILURE);
   }
@@ -83,7 +59,8 @@ int main(int argc, char* argv[]) {
 
 
   /******** main execution loop ********/
-  uint16_t instruction;
+  uint16_t instruction = 0;
+  int exit_code = EXIT_SUCCESS;
   sf::RenderWindow window(sf::VideoMode({CHIP8_WIDTH * SCALE, CHIP8_HEIGHT * SCALE}), "CHIP-8 Emulator");
 
   //Load Sound Buffer
@@ -139,7 +116,12 @@ int main(int argc, char* argv[]) {
       //Run multiple CPU cycles per frame
       int cycles_per_frame = 12; //Chip8 CPU's run about 8-16 instructions per frame I think???
       for (int i = 0; i < cycles_per_frame; i++) {
-        if (!emulateCycle(chip8_state, instruction, state_file)) {
+        Chip8Status status = emulateCycle(chip8_state, instruction, state_file);
+        if (status != CHIP8_RUNNING) {
+          if (status != CHIP8_HALTED) {
+            std::cerr << chip8StatusString(status) << " at PC 0x" << std::hex << chip8_state.PC << std::dec << "\n";
+            exit_code = EXIT_FAILURE;
+          }
           window.close();
           break;
         }
@@ -179,7 +161,7 @@ int main(int argc, char* argv[]) {
   writeStateToFile(chip8_state, instruction, state_file);
 
   cleanup(state_file);
-  return EXIT_SUCCESS;
+  return exit_code;
 }
 
 // Assume chip8.display is a 64x32 array of 0s and 1s
@@ -0,0 +1,92 @@
+"""Thin ctypes wrapper around libchip8env (see chip8_env.h)."""
+
+import ctypes
+import numpy as np
+
+CHIP8_WIDTH = 64
+CHIP8_HEIGHT = 32
+MEM_SIZE = 4096
+
+
+class Chip8Env:
+    def __init__(self, lib_path, rom_path, num_envs, frames_per_step=1, cycles_per_frame=12, num_threads=0):
+        # Set first so close()/__del__ are safe if anything below raises
+        self._env = None
+        lib = ctypes.CDLL(lib_path)
+        lib.chip8_env_create.restype = ctypes.c_void_p
+        lib.chip8_env_create.argtypes = [ctypes.c_char_p, ctypes.c_int, ctypes.c_int, ctypes.c_int, ctypes.c_int]
+        lib.chip8_env_destroy.argtypes = [ctypes.c_void_p]
+        lib.chip8_env_num_envs.restype = ctypes.c_int
+        lib.chip8_env_num_envs.argtypes = [ctypes.c_void_p]
+        lib.chip8_env_add_reward_hook.restype = ctypes.c_int
+        lib.chip8_env_add_reward_hook.argtypes = [ctypes.c_void_p, ctypes.c_uint16, ctypes.c_float]
+        lib.chip8_env_reset.argtypes = [ctypes.c_void_p, ctypes.c_void_p]
+        lib.chip8_env_reset_one.argtypes = [ctypes.c_void_p, ctypes.c_int, ctypes.c_uint64]
+        lib.chip8_env_step.argtypes = [ctypes.c_void_p, ctypes.c_void_p, ctypes.c_void_p, ctypes.c_void_p]
+        lib.chip8_env_observations.restype = ctypes.POINTER(ctypes.c_uint8)
+        lib.chip8_env_observations.argtypes = [ctypes.c_void_p]
+        lib.chip8_env_observation_stride.restype = ctypes.c_size_t
+        lib.chip8_env_memory.restype = ctypes.POINTER(ctypes.c_uint8)
+        lib.chip8_env_memory.argtypes = [ctypes.c_void_p, ctypes.c_int]
+
+        self._lib = lib
+        self._env = lib.chip8_env_create(rom_path.encode(), num_envs, frames_per_step, cycles_per_frame, num_threads)
+        if not self._env:
+            raise RuntimeError("chip8_env_create failed for " + rom_path)
+
+        self.num_envs = lib.chip8_env_num_envs(self._env)
+        self.rewards = np.zeros(num_envs, dtype=np.float32)
+        self.dones = np.zeros(num_envs, dtype=np.uint8)
+
+        # Strided view straight onto each instance's framebuffer; no copy is made
+        stride = lib.chip8_env_observation_stride()
+        base = lib.chip8_env_observations(self._env)
+        raw = np.ctypeslib.as_array(base, shape=(stride * (num_envs - 1) + CHIP8_WIDTH * CHIP8_HEIGHT,))
+        self.observations = np.lib.stride_tricks.as_strided(
+            raw, shape=(num_envs, CHIP8_HEIGHT, CHIP8_WIDTH), strides=(stride, CHIP8_WIDTH, 1), writeable=False)
+
+    def memory(self, index):
+        """Read-only view of one instance's 4KB memory; like observations, it is invalidated by close()."""
+        if not 0 <= index < self.num_envs:
+            raise IndexError("instance index out of range: %d" % index)
+        mem = np.ctypeslib.as_array(self._lib.chip8_env_memory(self._env, index), shape=(MEM_SIZE,))
+        mem.flags.writeable = False
+        return mem
+
+    def add_reward_hook(self, addr, scale=1.0):
+        if self._lib.chip8_env_add_reward_hook(self._env, addr, scale) != 0:
+            raise ValueError("address out of range: " + hex(addr))
+
+    def reset(self, seeds=None):
+        if seeds is None:
+            self._lib.chip8_env_reset(self._env, None)
+        else:
+            seeds = np.ascontiguousarray(seeds, dtype=np.uint64)
+            if seeds.shape != (self.num_envs,):
+                raise ValueError("expected %d seeds, got shape %s" % (self.num_envs, seeds.shape))
+            self._lib.chip8_env_reset(self._env, seeds.ctypes.data)
+        return self.observations
+
+    def reset_one(self, index, seed):
+        if not 0 <= index < self.num_envs:
+            raise IndexError("instance index out of range: %d" % index)
+        self._lib.chip8_env_reset_one(self._env, index, seed)
+
+    def step(self, actions):
+        """actions: one 16-bit keypad mask per instance (bit k set = key k held)."""
+        actions = np.ascontiguousarray(actions, dtype=np.uint16)
+        if actions.shape != (self.num_envs,):
+            raise ValueError("expected actions of shape (%d,), got %s" % (self.num_envs, actions.shape))
+        self._lib.chip8_env_step(self._env, actions.ctypes.data, self.rewards.ctypes.data, self.dones.ctypes.data)
+        return self.observations, self.rewards, self.dones
+
+    def close(self):
+        """Frees the instances. Views previously returned as observations must not be used afterwards."""
+        if self._env:
+            # Drop our view before the memory behind it goes away
+            self.observations = None
+            self._lib.chip8_env_destroy(self._env)
+            self._env = None
+
+    def __del__(self):
+        self.close()